@@ -5,10 +5,24 @@
  * Parses FluidNC/GRBL status messages from USART0 and drives a small
  * RGB LED chain (NeoPixel) to visualize the current machine state.
  *
- * - Before a "[MSG:INFO: Connected" message is received, the LED blinks
- *   red <-> purple to indicate waiting-for-boot.
+ * - Before the controller's boot message (@ref MSG_BOOTED) is received, the LED
+ *   blinks red <-> purple to indicate waiting-for-boot.
+ * - The controller dialect (FluidNC, grblHAL, GRBL 1.1) is chosen at compile
+ *   time with @ref GRBL_DIALECT.
+ * - A status request is sent right at startup, so if the controller booted
+ *   before us, its first well-formed "<...>" report attaches us to it.
  * - After BOOTED, the LED color reflects current GRBL status (Idle, Run, etc.).
+ * - After a watchdog/brown-out/software reset, the last shown status is restored
+ *   from CRC-guarded .noinit SRAM and revalidated with a single status request.
  * - If no status update is seen for a while, periodically requests status ("?\n").
+ * - With @ref FEED_METER, achieved ("FS:") vs. programmed ("[GC:...F") feed is
+ *   tracked during Run, and a chronically feed-limited Run is shown in blue.
+ *   "[GC:" lines are read as the sender requests them; @ref FEED_GC_POLL asks itself.
+ * - Runtime counters live in a fixed-address SRAM block (@ref Stats) that a host
+ *   reads over UPDI (tools/read_stats.py), so diagnostics cost no serial traffic.
+ * - With @ref RENDER_SLAVE, none of the above: USART0 receives COBS-framed,
+ *   CRC-checked pixel frames from a host and the firmware only drives the LEDs,
+ *   acknowledging each LED update so the host never sends while show() runs.
  *
  * @note MCU: ATtiny412 (AVR-0/1 series)
  * @note LED: WS2812-compatible on PA3 (alternate USART on PA1/PA2)
@@ -21,22 +35,26 @@
 #define USART0_BAUD_RATE(BAUD_RATE) ((float)(F_CPU * 64 / (16 * (float)(BAUD_RATE))) + 0.5f)
 #endif
 
-//#define DEBUG 1
-
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
-#include <stdio.h>
+#include <stddef.h>
+#include <util/crc16.h>       // _crc8_ccitt_update() for the retained state block
 
+#include <avr/pgmspace.h>         // PROGMEM tables for precomputed LED frames
 #include <tinyNeoPixel_Static.h>  // NeoPixel driver (uses global pixel buffer)
 
 // ================== Hardware / Pins ==================
 #define LED        PIN_PA3  ///< NeoPixel data pin.
 #define TX         PIN_PA1  ///< USART TX (info only, pin config is done in uart_init()).
 #define RX         PIN_PA2  ///< USART RX (info only).
+#ifndef BAUDRATE
 #define BAUDRATE   115200   ///< USART baud rate.
+#endif
 
+#ifndef NUM_LEDS
 #define NUM_LEDS   2        ///< Number of NeoPixels in the chain.
+#endif
 #define BRIGHTNESS 31       ///< Global NeoPixel brightness (0..255).
 
 // ================== Colors ==================
@@ -46,14 +64,132 @@
 #define COL_GRN 0x00ff00u  ///< Green
 #define COL_CYA 0x007fffu  ///< Cyan
 #define COL_PUR 0xff00ffu  ///< Purple (magenta)
+#define COL_BLU 0x0000ffu  ///< Blue (Run, feed-limited)
+
+/// @brief Scale one channel by @ref BRIGHTNESS, bit-exact with tinyNeoPixel::setBrightness().
+#define SCALE(c)   ((uint8_t)(((uint16_t)(c) * (BRIGHTNESS + 1u)) >> 8))
+/// @brief Brightness-scaled GRB byte frame of a 0xRRGGBB color, for flash tables.
+#define FRAME(rgb) { SCALE(((rgb) >> 8) & 0xffu), SCALE(((rgb) >> 16) & 0xffu), SCALE((rgb) & 0xffu) }
+
+/**
+ * @enum Color
+ * @brief Index into the precomputed frame table @ref PALETTE.
+ */
+typedef enum Color {
+  PAL_RED,  ///< @ref COL_RED
+  PAL_ORA,  ///< @ref COL_ORA
+  PAL_YEL,  ///< @ref COL_YEL
+  PAL_GRN,  ///< @ref COL_GRN
+  PAL_CYA,  ///< @ref COL_CYA
+  PAL_PUR,  ///< @ref COL_PUR
+  PAL_BLU,  ///< @ref COL_BLU
+} Color;
 
 // ================== Timings (ms) ==================
 #define BLINK_INTERVAL      250u   ///< Startup blink period before BOOTED is seen.
 #define REQUEST_TIMEOUT_MS  5000u  ///< If no status for this long, send "?\n" to FluidNC.
 
+// ================== Features ==================
+// Each switch can be overridden from build_flags (see the envs in platformio.ini).
+// A disabled feature compiles to nothing: no code, no SRAM, no runtime branch.
+//#define DEBUG 1
+#ifndef ATTACH_ON_REPORT
+#define ATTACH_ON_REPORT 1  ///< Poll at startup and accept any well-formed "<...>" report as a live link.
+#endif
+#ifndef WARM_RESTART
+#define WARM_RESTART 1      ///< Resume the last shown status after a non-power-on reset.
+#endif
+#define WARM_REVALIDATE_MS  1000u  ///< Back to the boot blink if the poll after a warm reset is not answered in time.
+#ifndef RENDER_SLAVE
+#define RENDER_SLAVE 0      ///< Ignore GRBL; show pixel frames received from a host instead.
+#endif
+#ifndef STATS_BLOCK
+#define STATS_BLOCK 1       ///< Keep runtime counters in the fixed-address @ref Stats block.
+#endif
+#ifndef STATS_LOOP_TIME
+#define STATS_LOOP_TIME 0   ///< With @ref STATS_BLOCK, track the longest loop() pass (one micros() call per pass).
+#endif
+#ifndef FEED_METER
+#define FEED_METER 0        ///< Measure achieved vs. programmed feed in Run.
+#endif
+#ifndef FEED_GC_POLL
+#define FEED_GC_POLL 0      ///< With @ref FEED_METER, request "$G" during Run instead of relying on the sender's.
+#endif
+#ifndef SET_REPORT_MASK
+#define SET_REPORT_MASK 0   ///< After power-on, send @ref REPORT_MASK_CMD once the controller is idle (writes a controller setting!).
+#endif
+
+// ================== Controller dialect ==================
+#define DIALECT_FLUIDNC 0  ///< FluidNC (ESP32).
+#define DIALECT_GRBLHAL 1  ///< grblHAL.
+#define DIALECT_GRBL11  2  ///< Classic GRBL 1.1 (AVR).
+
+#ifndef GRBL_DIALECT
+#define GRBL_DIALECT DIALECT_FLUIDNC  ///< Controller firmware the indicator is attached to.
+#endif
+
+// ================== Render-slave frames ==================
+// Wire format: COBS-encoded frame followed by a 0x00 delimiter. Decoded frame:
+// [type][payload...][CRC-8 CCITT over type + payload].
+#define SLAVE_FRAME_FULL    0x01u  ///< Payload: NUM_LEDS * 3 GRB bytes.
+#define SLAVE_FRAME_DELTA   0x02u  ///< Payload: byte offset into pixels[] (16-bit LE), then GRB bytes.
+#define SLAVE_FRAME_MAX     (NUM_LEDS * 3 + 4)  ///< Largest decoded frame (delta covering all pixels).
+#ifndef SLAVE_FRAME_INTERVAL_MS
+#define SLAVE_FRAME_INTERVAL_MS 1u  ///< Minimum time between two show() calls.
+#endif
+// show() runs ~30 us per LED with interrupts off, while the polled USART holds only
+// ~3 bytes, so anything sent during it is lost. One ACK byte goes out after every
+// show(); the host sends the next frame only after it (stop-and-wait). A higher
+// BAUDRATE only shortens the transfers, it does not lift this limit.
+#define SLAVE_ACK           0x06u  ///< Sent after each show(): frame applied, ready for the next.
+
+// ================== Status report mask ==================
+// $10 selects the optional report fields; only the state word is consumed here.
+// The setting is persistent, so it is sent only after a power-on reset, never after
+// warm resets (watchdog, brown-out, UPDI). Bit 0 is cleared in every dialect, which
+// switches all report consumers, including the sender, from MPos to WPos for no
+// saving (same size).
+#if GRBL_DIALECT == DIALECT_GRBLHAL
+// grblHAL: bit 0 MPos, 1 Bf, 2 Ln, 3 FS, 4 Pn, 5 WCO, 6 Ov, 7 probe, ...
+// All optional fields are turned off, except FS when the feed meter needs it.
+#if FEED_METER
+#define REPORT_MASK 8
+#else
+#define REPORT_MASK 0
+#endif
+#else
+// FluidNC ($Report/Status) and GRBL 1.1: bit 0 MPos (else WPos, same size),
+// bit 1 "|Bf:" buffer state. FS, WCO and Ov are always sent; 0 drops Bf and
+// selects WPos.
+#define REPORT_MASK 0
+#endif
+#define STR_(x) #x
+#define STR(x)  STR_(x)  ///< Stringify a macro value.
+#define REPORT_MASK_CMD "$10=" STR(REPORT_MASK) "\n"  ///< Report mask matching the fields used by this firmware.
+
+// ================== Feed efficiency meter ==================
+#define FEED_EFF_ONE     256u   ///< 100 % efficiency in Q8 fixed point.
+#define FEED_EFF_WINDOW  8u     ///< Averaging window in reports (exponential moving average).
+#define FEED_EFF_LOW     128u   ///< Average below this (50 %) tints the Run color.
+#define FEED_EFF_OK      160u   ///< Average above this (62 %) restores it (hysteresis).
+#define FEED_GC_POLL_MS  1000u  ///< Interval of "$G" (parser state) requests during Run, see @ref FEED_GC_POLL.
+#define FEED_GC_CMD      "$G\n" ///< Request for the "[GC:...]" parser state line.
+
 // ================== GRBL messages to parse ==================
+// State words are common to all dialects. Sub-states ("Hold:0", "Door:1") and the
+// field separator ('|' in 1.1, ',' in older GRBL) follow the prefix, so they need
+// no special handling. Only the boot banner and extra states differ.
 #define MAX_PARSE_LEN 25  ///< Maximum parsed string length (prefix-only compare).
+#if GRBL_DIALECT == DIALECT_FLUIDNC
 #define MSG_BOOTED "[MSG:INFO: Connected"
+#elif GRBL_DIALECT == DIALECT_GRBLHAL
+#define MSG_BOOTED "GrblHAL "    ///< Welcome banner, e.g. "GrblHAL 1.1f ['$' or '$HELP' for help]".
+#define MSG_TOOL   "<Tool"       ///< Waiting for manual tool change; shown like Hold.
+#elif GRBL_DIALECT == DIALECT_GRBL11
+#define MSG_BOOTED "Grbl 1.1"    ///< Welcome banner, e.g. "Grbl 1.1h ['$' for help]".
+#else
+#error "Unsupported GRBL_DIALECT"
+#endif
 #define MSG_IDLE   "<Idle"
 #define MSG_RUN    "<Run"
 #define MSG_HOLD   "<Hold"
@@ -61,6 +197,8 @@
 #define MSG_DOOR   "<Door"
 #define MSG_HOME   "<Home"
 #define MSG_ALARM  "<Alarm"
+#define MSG_GC     "[GC:"       ///< Parser state (answer to "$G"), carries the programmed F.
+#define MSG_GC_G0  "[GC:G0 "    ///< Parser state in rapid mode: F does not apply.
 
 /**
  * @enum Status
@@ -82,18 +220,119 @@ typedef enum Status {
 byte pixels[NUM_LEDS * 3];
 tinyNeoPixel leds = tinyNeoPixel(NUM_LEDS, LED, NEO_GRB + NEO_KHZ800, pixels);
 
+// ================== Stats block (read over UPDI) ==================
+#define STATS_VERSION 3u    ///< Bump when the layout of @ref Stats changes.
+#define STATS_SIZE    34u   ///< Bytes reserved for @ref Stats at the top of SRAM.
+// Nothing in the linker script reserves this block. stats_init() exports STATS_ADDR
+// as the absolute symbol __stats_start (data space, 0x800000 offset); platformio.ini
+// puts __stack right below it, and tools/check_ram_layout.py fails the build if
+// .data/.bss/.noinit reach into it (e.g. with a large NUM_LEDS).
+#define STATS_ADDR    (RAMEND + 1u - STATS_SIZE)  ///< Fixed address of @ref Stats.
+
+/**
+ * @struct Stats
+ * @brief Runtime counters, decoded by tools/read_stats.py. All counters wrap.
+ *
+ * Cleared on power-on reset only, so values survive the reset caused by a
+ * UPDI session and can be read back after a watchdog or brown-out reset.
+ */
+typedef struct Stats {
+  uint8_t  version;              ///< @ref STATS_VERSION
+  uint8_t  size;                 ///< sizeof(Stats)
+  uint16_t lines;                ///< Complete lines received.
+  uint16_t perState[ALARM + 1];  ///< Lines decoded per @ref Status (BOOTED..ALARM).
+  uint16_t rxErrors;             ///< Bytes received with framing or parity error.
+  uint16_t rxOverruns;           ///< USART receive buffer overflows.
+  uint16_t polls;                ///< Requests sent: status ("?\n") and, with @ref FEED_GC_POLL, "$G".
+  uint16_t shows;                ///< leds.show() calls.
+  uint16_t maxLoopUs;            ///< Longest time between two loop() entries, in us (@ref STATS_LOOP_TIME).
+  uint16_t feedEff;              ///< Average feed efficiency in Run, Q8 (256 = 100 %).
+  uint16_t warmRestarts;         ///< Resets after which the retained status was resumed.
+} Stats;
+
+#if STATS_BLOCK
+static_assert(sizeof(Stats) <= STATS_SIZE, "Stats does not fit the reserved SRAM");
+#define stats (*(Stats *)STATS_ADDR)  ///< The stats block itself.
+#define STAT_INC(field) (stats.field++)
+#else
+#define STAT_INC(field) ((void)0)
+#endif
+
+// ================== Debug event trace ==================
+// With DEBUG, events are recorded into a small SRAM ring and sent to TX one byte
+// per loop, only after RX has been quiet for TRACE_IDLE_MS. TX is wired to the
+// controller's RX, so records are GRBL comments made of hex digits only
+// ("(EttttDD)": event, millis() & 0xFFFF, data), which can never form a realtime
+// command. Before a record that comes TRACE_SYNC_MS or more after the last sync,
+// "(Stttttttt)" carries its full millis(), so the 16-bit stamps can be unwrapped
+// across any gap. Nothing is sent while there are no records.
+// tools/trace_decode.py turns them back into a timeline.
+#define TRACE_LEN      8u      ///< Records in the trace ring (power of two).
+#define TRACE_IDLE_MS  2u      ///< RX silence required before trace output.
+#define TRACE_SYNC_MS  10000u  ///< Maximum interval between two time-sync records.
+#define TRACE_LINE_MAX 64u     ///< Comment chars after which the line is ended with '\n'.
+
+/**
+ * @enum TraceEvent
+ * @brief Event types of the debug trace (first hex digit of a record).
+ */
+typedef enum TraceEvent {
+  EV_LINE,    ///< Line complete; data = stored length.
+  EV_STATUS,  ///< Line decoded; data = @ref Status.
+  EV_POLL,    ///< Request sent; data = 0 for "?", 1 for "$G".
+  EV_SHOW,    ///< LED updated; data = @ref Color.
+  EV_RXERR,   ///< Receive error; data = USART0.RXDATAH flags.
+  EV_LOST,    ///< Ring was full; data = number of dropped records (saturating).
+} TraceEvent;
+
+#ifdef DEBUG
+#define TRACE(ev, data) trace((ev), (uint8_t)(data))
+#else
+#define TRACE(ev, data) ((void)0)
+#endif
+
 // ================== Forward declarations (Arduino provides prototypes, but Doxygen likes these) ==================
 static void uart_init(void);
 static bool uart_available(void);
 static uint8_t uart_read(void);
 static void uart_write(uint8_t b);
 static void uart_write_str(const char *str);
-static void setColor(uint32_t color);
+static void request_status(void);
+static void setColor(Color color);
 static void showStatus(Status st);
+static void updateShown(Status st);
+#if WARM_RESTART
+static uint8_t retained_crc(void);
+static bool retained_restore(uint8_t cause);
+static void retained_store(Status st);
+#endif
+#if WARM_RESTART || STATS_BLOCK || SET_REPORT_MASK
+static uint8_t reset_cause(void);
+#endif
+#if STATS_BLOCK
+static void stats_init(uint8_t cause);
+#if STATS_LOOP_TIME
+static void stats_loop_tick(void);
+#endif
+#endif
+static Status decode_line(const char *buf, bool complete);
 static Status parse_status(void);
+#if FEED_METER
+static void feed_scan(char c, const char *line, uint8_t idx);
+static void feed_line_end(Status st);
+static bool feed_update(Status st, uint32_t now);
+#endif
+#if RENDER_SLAVE
+static bool slave_apply(const uint8_t *frame, uint8_t len);
+static bool slave_receive(void);
+#endif
 
 #ifdef DEBUG
-static void debugPrint(const char *buf);
+static void trace(TraceEvent ev, uint8_t data);
+static uint8_t trace_hex(uint8_t pos, uint32_t value, uint8_t digits);
+static bool trace_next(void);
+static void trace_drain(void);
+static void trace_flush(bool endLine);
 #endif
 
 // ================== USART0 (register-level) ==================
@@ -127,12 +366,31 @@ static bool uart_available(void) {
   return (USART0.STATUS & USART_RXCIF_bm);
 }
 
+#ifdef DEBUG
+static uint32_t traceRxMs = 0;  ///< millis() of the last received byte, see trace_drain().
+#endif
+
 /**
  * @brief Read one byte from USART0.
+ *
+ * RXDATAH is read first (it holds the error flags of the byte in RXDATAL),
+ * so receive errors can be counted in @ref Stats and traced.
+ *
  * @warning Call only if @ref uart_available returned true.
  * @return The received byte.
  */
 static uint8_t uart_read(void) {
+#if STATS_BLOCK || defined(DEBUG)
+  const uint8_t flags = USART0.RXDATAH;
+  if (flags & (USART_FERR_bm | USART_PERR_bm | USART_BUFOVF_bm)) {
+    if (flags & (USART_FERR_bm | USART_PERR_bm)) STAT_INC(rxErrors);
+    if (flags & USART_BUFOVF_bm) STAT_INC(rxOverruns);
+    TRACE(EV_RXERR, flags);
+  }
+#endif
+#ifdef DEBUG
+  traceRxMs = millis();
+#endif
   return USART0.RXDATAL;
 }
 
@@ -152,67 +410,389 @@ static void uart_write(uint8_t b) {
  * @param str Pointer to a null-terminated string.
  */
 static void uart_write_str(const char *str) {
+#ifdef DEBUG
+  trace_flush(str[0] != '?');  // "?\n" ends a line of trace comments itself
+#endif
   for (size_t i = 0; i < strlen(str); i++) {
     uart_write((uint8_t)str[i]);
   }
 }
 
+/**
+ * @brief Ask the controller for a status report ("?\n").
+ */
+static void request_status(void) {
+  uart_write_str("?\n");
+  STAT_INC(polls);
+  TRACE(EV_POLL, 0);
+}
+
+// ================== Feed efficiency meter ==================
+#if FEED_METER
+#define FEED_FIELD_NONE       0u  ///< Not inside a feed number.
+#define FEED_FIELD_ACTUAL     1u  ///< Reading "FS:<feed>" or "F:<feed>" of a status report.
+#define FEED_FIELD_PROGRAMMED 2u  ///< Reading " F<feed>" of a "[GC:" line.
+
+static uint16_t feedActual     = 0;      ///< Last reported feed (units/min, integer part).
+static uint16_t feedProgrammed = 0;      ///< Last programmed F; 0 if unknown or in G0.
+static uint16_t feedEffAcc     = FEED_EFF_ONE * FEED_EFF_WINDOW;  ///< EMA accumulator, Q8 * window.
+static bool     feedLow        = false;  ///< Average efficiency is below @ref FEED_EFF_LOW.
+static bool     feedFresh      = false;  ///< The last report carried "FS:"/"F:".
+
+static char     feedPrev1 = '\0';         // last scanned char
+static char     feedPrev2 = '\0';         // char before feedPrev1
+static uint8_t  feedField = FEED_FIELD_NONE;
+static uint16_t feedValue = 0;
+
+/**
+ * @brief Scan one received char for the feed fields, without buffering the line.
+ *
+ * Reports carry the actual feed as "FS:<feed>,<speed>" (or "F:<feed>" without
+ * a variable spindle), "[GC:...]" lines the programmed " F<feed>". Only the
+ * integer part is used.
+ *
+ * @param c    Received char (not CR or LF).
+ * @param line Beginning of the current line as stored so far.
+ * @param idx  Number of chars in @p line.
+ */
+static void feed_scan(char c, const char *line, uint8_t idx) {
+  if (feedField != FEED_FIELD_NONE) {
+    if ((c >= '0') && (c <= '9')) {
+      if (feedValue < 6553u) {
+        feedValue = (uint16_t)(feedValue * 10u + (uint8_t)(c - '0'));
+      }
+    } else if (feedField == FEED_FIELD_ACTUAL) {
+      feedActual = feedValue;
+      feedFresh  = true;
+      feedField  = FEED_FIELD_NONE;
+    } else {
+      feedProgrammed = (strncmp(line, MSG_GC_G0, strlen(MSG_GC_G0)) == 0) ? 0u : feedValue;
+      feedField      = FEED_FIELD_NONE;
+    }
+  } else if ((idx > 0u) && (line[0] == '<') && (c == ':') &&
+             (((feedPrev1 == 'S') && (feedPrev2 == 'F')) ||
+              ((feedPrev1 == 'F') && (feedPrev2 == '|')))) {
+    feedField = FEED_FIELD_ACTUAL;
+    feedValue = 0;
+  } else if ((c == 'F') && (feedPrev1 == ' ') && (idx >= strlen(MSG_GC)) &&
+             (strncmp(line, MSG_GC, strlen(MSG_GC)) == 0)) {
+    feedField = FEED_FIELD_PROGRAMMED;
+    feedValue = 0;
+  }
+
+  feedPrev2 = feedPrev1;
+  feedPrev1 = c;
+}
+
+/**
+ * @brief Reset the field scanner at end of line (drops an unterminated number).
+ *
+ * A feed from a line that was not accepted as a report (e.g. "<Run" without
+ * '>') is dropped too, so it is never counted with the next report.
+ *
+ * @param st Status decoded from the line.
+ */
+static void feed_line_end(Status st) {
+  feedPrev1 = '\0';
+  feedPrev2 = '\0';
+  feedField = FEED_FIELD_NONE;
+  if (st == UNKNOWN) {
+    feedFresh = false;
+  }
+}
+
+/**
+ * @brief Update the efficiency average from an accepted status report.
+ *
+ * During Run, each report that carried a feed adds achieved / programmed
+ * feed (Q8, capped at 100 %) to an exponential moving average over
+ * @ref FEED_EFF_WINDOW reports. The programmed feed comes from "[GC:" lines
+ * requested by the sender; with @ref FEED_GC_POLL "$G" is requested every
+ * @ref FEED_GC_POLL_MS instead. Outside Run the average is reset, so each job
+ * starts at 100 %.
+ *
+ * @param st  Status of the report.
+ * @param now Current millis().
+ * @return true if @ref feedLow changed (the Run color must be redrawn).
+ */
+static bool feed_update(Status st, uint32_t now) {
+#if FEED_GC_POLL
+  static uint32_t lastGcPollMs = 0;
+#endif
+  (void)now;  // unused without FEED_GC_POLL
+  const bool wasLow = feedLow;
+  const bool fresh  = feedFresh;
+  feedFresh = false;
+
+  if (st != RUN) {
+    feedEffAcc = FEED_EFF_ONE * FEED_EFF_WINDOW;
+#if FEED_GC_POLL
+    feedProgrammed = 0;                      // re-read for the next job
+    lastGcPollMs   = now - FEED_GC_POLL_MS;  // ask right when Run starts
+#endif
+  } else {
+    if (fresh && (feedProgrammed != 0u)) {
+      uint16_t eff = (uint16_t)(((uint32_t)feedActual << 8) / feedProgrammed);
+      if (eff > FEED_EFF_ONE) eff = FEED_EFF_ONE;  // overrides may exceed F
+      feedEffAcc = (uint16_t)(feedEffAcc - feedEffAcc / FEED_EFF_WINDOW + eff);
+    }
+#if FEED_GC_POLL
+    if ((now - lastGcPollMs) >= FEED_GC_POLL_MS) {
+      uart_write_str(FEED_GC_CMD);
+      STAT_INC(polls);
+      TRACE(EV_POLL, 1);
+      lastGcPollMs = now;
+    }
+#endif
+  }
+
+  const uint16_t avg = feedEffAcc / FEED_EFF_WINDOW;
+#if STATS_BLOCK
+  stats.feedEff = avg;
+#endif
+  feedLow = wasLow ? (avg <= FEED_EFF_OK) : (avg < FEED_EFF_LOW);
+  return feedLow != wasLow;
+}
+#endif
+
 // ================== LED helpers ==================
 
+/// @brief GRB frames per @ref Color, brightness already applied at compile time.
+static const uint8_t PALETTE[][3] PROGMEM = {
+  FRAME(COL_RED), FRAME(COL_ORA), FRAME(COL_YEL),
+  FRAME(COL_GRN), FRAME(COL_CYA), FRAME(COL_PUR),
+  FRAME(COL_BLU),
+};
+
+/// @brief @ref Color shown for each @ref Status from BOOTED to ALARM.
+static const uint8_t STATUS_COLOR[] PROGMEM = {
+  PAL_GRN,  // BOOTED
+  PAL_GRN,  // IDLE
+  PAL_CYA,  // RUN
+  PAL_YEL,  // HOLD
+  PAL_PUR,  // JOG
+  PAL_ORA,  // DOOR
+  PAL_PUR,  // HOME
+  PAL_RED,  // ALARM
+};
+
 /**
- * @brief Set all NeoPixels to a 24-bit RGB color and show.
- * @param color 24-bit color as 0xRRGGBB.
+ * @brief Copy a precomputed frame from flash to all NeoPixels and show.
+ *
+ * The bytes are written straight into @ref pixels in wire (GRB) order,
+ * bypassing tinyNeoPixel::fill() and its per-pixel brightness scaling.
+ *
+ * @param color Palette entry to show.
  */
-static void setColor(uint32_t color) {
-  leds.fill(color, 0, NUM_LEDS);
+static void setColor(Color color) {
+  const uint8_t g = pgm_read_byte(&PALETTE[color][0]);
+  const uint8_t r = pgm_read_byte(&PALETTE[color][1]);
+  const uint8_t b = pgm_read_byte(&PALETTE[color][2]);
+  for (uint16_t i = 0; i < sizeof(pixels); i += 3) {
+    pixels[i]      = g;
+    pixels[i + 1u] = r;
+    pixels[i + 2u] = b;
+  }
   leds.show();
+  STAT_INC(shows);
+  TRACE(EV_SHOW, color);
 }
 
 /**
  * @brief Display a color corresponding to a parsed GRBL status.
- * @param st Parsed status value.
+ * @param st Parsed status value; values outside BOOTED..ALARM leave the LED unchanged.
+ *           With @ref FEED_METER, a feed-limited Run is shown as @ref COL_BLU.
  */
 static void showStatus(Status st) {
-  switch (st) {
-    case BOOTED: setColor(COL_GRN); break;
-    case IDLE:   setColor(COL_GRN); break;
-    case RUN:    setColor(COL_CYA); break;
-    case HOLD:   setColor(COL_YEL); break;
-    case JOG:    setColor(COL_PUR); break;
-    case DOOR:   setColor(COL_ORA); break;
-    case HOME:   setColor(COL_PUR); break;
-    case ALARM:  setColor(COL_RED); break;
-    default:     /* no change */    break;
+#if FEED_METER
+  if ((st == RUN) && feedLow) {
+    setColor(PAL_BLU);  // running, but well below the programmed feed
+    return;
+  }
+#endif
+  if ((uint8_t)st < sizeof(STATUS_COLOR)) {
+    setColor((Color)pgm_read_byte(&STATUS_COLOR[st]));
   }
 }
 
-// ================== Debug print ==================
+// ================== Debug trace ==================
 #ifdef DEBUG
+static uint8_t  traceBuf[TRACE_LEN][4];  // [event][millis() lo][millis() hi][data]
+static uint8_t  traceHead    = 0;      // next record to write
+static uint8_t  traceTail    = 0;      // next record to send
+static uint8_t  traceLost    = 0;      // records dropped since the last EV_LOST
+static char     traceOut[12];          // text being sent, at most "\n(Stttttttt)"
+static uint8_t  traceOutLen  = 0;
+static uint8_t  traceOutPos  = 0;
+static uint8_t  traceLineLen = 0;      // chars sent since the last '\n'
+static uint32_t traceSyncMs  = 0;
+static bool     traceSynced  = false;  // first sync record sent
+
 /**
- * @brief Send the beginning of a received line and its length to TX.
- * @param buf Null-terminated buffer containing the received line.
+ * @brief Append one record to the trace ring (a few cycles, never blocks).
+ *
+ * If the ring is full the record is dropped and counted; the count is
+ * reported as @ref EV_LOST once there is room again.
+ *
+ * @param ev   Event type.
+ * @param data Event payload.
  */
-static void debugPrint(const char *buf) {
-  // Print at most MAX_PARSE_LEN characters to avoid spamming
-  for (uint8_t i = 0; i < (uint8_t)MAX_PARSE_LEN; i++) {
-    if (buf[i] == '\0') break;
-    uart_write((uint8_t)buf[i]);
+static void trace(TraceEvent ev, uint8_t data) {
+  const uint8_t next = (uint8_t)((traceHead + 1u) & (TRACE_LEN - 1u));
+  if (next == traceTail) {
+    if (traceLost < 0xFFu) traceLost++;
+    return;
   }
-  char ln[16];
-  (void)sprintf(ln, " --- %u", (unsigned)strlen(buf));
-  uart_write_str(ln);
-  uart_write((uint8_t)'\n');
+  const uint16_t ms = (uint16_t)millis();
+  traceBuf[traceHead][0] = (uint8_t)ev;
+  traceBuf[traceHead][1] = (uint8_t)ms;
+  traceBuf[traceHead][2] = (uint8_t)(ms >> 8);
+  traceBuf[traceHead][3] = data;
+  traceHead = next;
+}
+
+/**
+ * @brief Append @p digits upper-case hex digits of @p value to @ref traceOut.
+ * @return Position after the last digit.
+ */
+static uint8_t trace_hex(uint8_t pos, uint32_t value, uint8_t digits) {
+  while (digits--) {
+    const uint8_t n = (uint8_t)(value >> (4u * digits)) & 0x0Fu;
+    traceOut[pos++] = (char)((n < 10u) ? ('0' + n) : ('A' - 10u + n));
+  }
+  return pos;
+}
+
+/**
+ * @brief Format the next ring record, preceded by a sync record if due, into @ref traceOut.
+ * @return false if the ring is empty.
+ */
+static bool trace_next(void) {
+  if (traceHead == traceTail) {
+    return false;
+  }
+
+  const uint8_t *rec = traceBuf[traceTail];
+  const uint16_t ms  = ((uint16_t)rec[2] << 8) | rec[1];
+  const uint32_t now = millis();
+  const uint32_t at  = now - (uint16_t)((uint16_t)now - ms);  // full millis() of the record
+  uint8_t n = 0;
+
+  if (traceLineLen >= TRACE_LINE_MAX) {
+    traceOut[n++] = '\n';  // bound the comment-only line the controller collects
+  }
+  traceOut[n++] = '(';
+  if (!traceSynced || ((at - traceSyncMs) >= TRACE_SYNC_MS)) {
+    traceOut[n++] = 'S';  // the record itself follows with the next call
+    n = trace_hex(n, at, 8u);
+    traceSyncMs = at;
+    traceSynced = true;
+  } else {
+    n = trace_hex(n, rec[0], 1u);
+    n = trace_hex(n, ms, 4u);
+    n = trace_hex(n, rec[3], 2u);
+    traceTail = (uint8_t)((traceTail + 1u) & (TRACE_LEN - 1u));
+
+    if (traceLost != 0u) {
+      const uint8_t lost = traceLost;
+      traceLost = 0;
+      trace(EV_LOST, lost);
+    }
+  }
+  traceOut[n++] = ')';
+  traceOutLen = n;
+  traceOutPos = 0;
+  return true;
+}
+
+/**
+ * @brief Send the next trace character to TX in an idle gap (never blocks).
+ *
+ * Only if TX is free and no byte has been received for @ref TRACE_IDLE_MS, so
+ * the trace stays out of the way of the traffic it observes.
+ */
+static void trace_drain(void) {
+  if (!(USART0.STATUS & USART_DREIF_bm) || uart_available() ||
+      ((millis() - traceRxMs) < TRACE_IDLE_MS)) {
+    return;
+  }
+  if ((traceOutPos == traceOutLen) && !trace_next()) {
+    return;
+  }
+  const char c = traceOut[traceOutPos++];
+  traceLineLen = (c == '\n') ? 0u : (uint8_t)(traceLineLen + 1u);
+  USART0.TXDATAL = (uint8_t)c;
+}
+
+/**
+ * @brief Finish the record being sent before any other TX.
+ *
+ * A command is never swallowed by an open comment. Blocks for at most one
+ * record.
+ *
+ * @param endLine true to also end a line of trace comments, so a command does
+ *                not share it; false if the following TX ends the line itself.
+ */
+static void trace_flush(bool endLine) {
+  while (traceOutPos < traceOutLen) {
+    uart_write((uint8_t)traceOut[traceOutPos++]);
+  }
+  if (endLine && (traceLineLen != 0u)) {
+    uart_write('\n');
+  }
+  traceLineLen = 0;  // all callers' TX ends with '\n'
 }
 #endif
 
 // ================== GRBL line parser (non-blocking) ==================
 
+/**
+ * @brief Match a complete line against the known message prefixes.
+ *
+ * Status reports are dispatched on their first letter, so at most two prefixes
+ * are compared per line. The set of cases is fixed by @ref GRBL_DIALECT.
+ *
+ * @param buf      Null-terminated (possibly truncated) beginning of the line.
+ * @param complete true if the full line ended with '>'.
+ * @return Matched @ref Status, or @ref UNKNOWN.
+ */
+static Status decode_line(const char *buf, bool complete) {
+  if (buf[0] == '\0') {
+    return UNKNOWN;
+  }
+
+  if (buf[0] != '<') {
+    if (strncmp(buf, MSG_BOOTED, strlen(MSG_BOOTED)) == 0) return BOOTED;
+    return UNKNOWN;  // not a status report
+  }
+  if (!complete) return UNKNOWN;  // truncated or garbled report
+
+  #define MATCH(msg, st) if (strncmp(buf, msg, strlen(msg)) == 0) return st
+  switch (buf[1]) {
+    case 'I': MATCH(MSG_IDLE,  IDLE);  break;
+    case 'R': MATCH(MSG_RUN,   RUN);   break;
+    case 'H': MATCH(MSG_HOLD,  HOLD);
+              MATCH(MSG_HOME,  HOME);  break;
+    case 'J': MATCH(MSG_JOG,   JOG);   break;
+    case 'D': MATCH(MSG_DOOR,  DOOR);  break;
+    case 'A': MATCH(MSG_ALARM, ALARM); break;
+#ifdef MSG_TOOL
+    case 'T': MATCH(MSG_TOOL,  HOLD);  break;
+#endif
+    default:  break;
+  }
+  #undef MATCH
+
+  return UNKNOWN;  // complete line but not matched any message
+}
+
 /**
  * @brief Incrementally parse characters from USART into a short line buffer.
  *
  * Collects characters until LF (\\n). CR (\\r) is ignored to support CR+LF sources.
  * Only the beginning of the line is stored (up to @ref MAX_PARSE_LEN - 1),
- * because matching is done on known message prefixes.
+ * because matching is done on known message prefixes. Status reports ("<...")
+ * are only accepted when the line is well-formed, i.e. ends with '>'.
  *
  * @return Parsed @ref Status if a recognized message prefix is found
  *         at end-of-line; otherwise @ref UNKNOWN.
@@ -220,6 +800,7 @@ static void debugPrint(const char *buf) {
 static Status parse_status(void) {
   static char lineBuf[MAX_PARSE_LEN];
   static uint8_t idx = 0;
+  static char lastChar = '\0';  // last stored-or-dropped char, for the '>' check
 
   while (uart_available()) {
     char c = (char)uart_read();
@@ -228,29 +809,26 @@ static Status parse_status(void) {
     }
 
     if (c == '\n') {  // end of line
+      STAT_INC(lines);
+      TRACE(EV_LINE, idx);
       lineBuf[idx] = '\0';
       idx = 0;
+      const bool complete = (lastChar == '>');
+      lastChar = '\0';
 
-      #ifdef DEBUG
-      debugPrint(lineBuf);
-      #endif
-
-      if (lineBuf[0] == '\0') {
-        return UNKNOWN;
-      }
-
-      if (strncmp(lineBuf, MSG_BOOTED, strlen(MSG_BOOTED)) == 0) return BOOTED;
-      if (strncmp(lineBuf, MSG_IDLE,   strlen(MSG_IDLE))   == 0) return IDLE;
-      if (strncmp(lineBuf, MSG_RUN,    strlen(MSG_RUN))    == 0) return RUN;
-      if (strncmp(lineBuf, MSG_HOLD,   strlen(MSG_HOLD))   == 0) return HOLD;
-      if (strncmp(lineBuf, MSG_JOG,    strlen(MSG_JOG))    == 0) return JOG;
-      if (strncmp(lineBuf, MSG_DOOR,   strlen(MSG_DOOR))   == 0) return DOOR;
-      if (strncmp(lineBuf, MSG_HOME,   strlen(MSG_HOME))   == 0) return HOME;
-      if (strncmp(lineBuf, MSG_ALARM,  strlen(MSG_ALARM))  == 0) return ALARM;
-
-      return UNKNOWN;  // complete line but not matched any message
+      const Status st = decode_line(lineBuf, complete);
+#if FEED_METER
+      feed_line_end(st);
+#endif
+      TRACE(EV_STATUS, st);
+      return st;
     }
 
+    lastChar = c;
+#if FEED_METER
+    feed_scan(c, lineBuf, idx);
+#endif
+
     // Store only the initial part needed for prefix matching
     if (idx < (sizeof(lineBuf) - 1u)) {
       lineBuf[idx++] = c;
@@ -261,6 +839,232 @@ static Status parse_status(void) {
   return UNKNOWN;  // no full line yet
 }
 
+// ================== Render-slave mode ==================
+#if RENDER_SLAVE
+static_assert(SLAVE_FRAME_MAX <= 255, "frame length must fit uint8_t, reduce NUM_LEDS");
+
+/**
+ * @brief Check a decoded frame and copy its pixels into @ref pixels.
+ * @param frame Decoded frame including type and CRC bytes.
+ * @param len   Number of bytes in @p frame.
+ * @return true if the frame was valid and @ref pixels changed.
+ */
+static bool slave_apply(const uint8_t *frame, uint8_t len) {
+  if (len < 2u) {
+    return false;
+  }
+
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < (uint8_t)(len - 1u); i++) {
+    crc = _crc8_ccitt_update(crc, frame[i]);
+  }
+  if (crc != frame[len - 1u]) {
+    return false;  // corrupted on the wire
+  }
+
+  const uint8_t *data = &frame[1];
+  uint16_t offset = 0;
+  uint8_t  count  = len - 2u;  // minus type and CRC
+
+  if (frame[0] == SLAVE_FRAME_FULL) {
+    if (count != sizeof(pixels)) {
+      return false;
+    }
+  } else if (frame[0] == SLAVE_FRAME_DELTA) {
+    if (count < 2u) {
+      return false;
+    }
+    offset = (uint16_t)frame[1] | ((uint16_t)frame[2] << 8);
+    data  += 2;
+    count -= 2u;
+    if ((offset + count) > sizeof(pixels)) {
+      return false;
+    }
+  } else {
+    return false;  // unknown frame type
+  }
+
+  memcpy(&pixels[offset], data, count);
+  return true;
+}
+
+/**
+ * @brief Incrementally COBS-decode bytes from USART into a frame buffer.
+ *
+ * A frame is decoded into a staging buffer and applied only after its CRC
+ * matched, so a broken frame never reaches the LEDs. Oversized frames are
+ * dropped up to the next delimiter.
+ *
+ * @return true if at least one valid frame was applied to @ref pixels.
+ */
+static bool slave_receive(void) {
+  static uint8_t frameBuf[SLAVE_FRAME_MAX];
+  static uint8_t len      = 0;
+  static uint8_t code     = 0xFFu;  // code of the current COBS block
+  static uint8_t left     = 0;      // data bytes left in the current block
+  static bool    overflow = false;
+  bool applied = false;
+
+  while (uart_available()) {
+    const uint8_t b = uart_read();
+
+    if (b == 0u) {  // frame delimiter
+      if (!overflow && slave_apply(frameBuf, len)) {
+        applied = true;
+      }
+      len      = 0;
+      code     = 0xFFu;
+      left     = 0;
+      overflow = false;
+      continue;
+    }
+
+    uint8_t out;
+    if (left == 0u) {  // b is a block code
+      const bool zero = (code != 0xFFu);  // previous block ended with an implicit 0x00
+      code = b;
+      left = b - 1u;
+      if (!zero) {
+        continue;
+      }
+      out = 0u;
+    } else {
+      out = b;
+      left--;
+    }
+
+    if (len < sizeof(frameBuf)) {
+      frameBuf[len++] = out;
+    } else {
+      overflow = true;
+    }
+  }
+
+  return applied;
+}
+#endif
+
+// ================== Reset cause ==================
+#if WARM_RESTART || STATS_BLOCK || SET_REPORT_MASK
+/**
+ * @brief Read and clear the reset flags.
+ *
+ * Recent megaTinyCore versions (without Optiboot) read and clear
+ * RSTCTRL.RSTFR in .init3 and leave the flags in GPIOR0; older versions
+ * leave RSTFR alone. GPIOR0 is 0 after any reset, so merging both works
+ * with either core.
+ *
+ * @return RSTCTRL_*RF_bm flags of the last reset.
+ */
+static uint8_t reset_cause(void) {
+  const uint8_t cause = RSTCTRL.RSTFR | GPIOR0;
+  RSTCTRL.RSTFR = cause;  // flags are cleared by writing 1
+  return cause;
+}
+#endif
+
+// ================== Warm restart (.noinit) ==================
+#if WARM_RESTART
+#define RETAINED_MAGIC 0xA5u  ///< Marks a retained block written by this firmware.
+
+/**
+ * @struct Retained
+ * @brief State kept across non-power-on resets; not cleared by the C runtime.
+ */
+typedef struct Retained {
+  uint8_t magic;     ///< @ref RETAINED_MAGIC when valid.
+  uint8_t shown;     ///< Last shown @ref Status.
+  uint8_t crc;       ///< CRC-8 (CCITT) over the fields above.
+} Retained;
+
+static Retained retained __attribute__((section(".noinit")));
+
+/**
+ * @brief CRC-8 over all fields of @ref retained except the CRC itself.
+ * @return Computed CRC.
+ */
+static uint8_t retained_crc(void) {
+  const uint8_t *p = (const uint8_t *)&retained;
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < (uint8_t)offsetof(Retained, crc); i++) {
+    crc = _crc8_ccitt_update(crc, p[i]);
+  }
+  return crc;
+}
+
+/**
+ * @brief Check the reset cause and the retained block.
+ *
+ * The block is trusted only if this was not a power-on reset and magic and
+ * CRC match. Otherwise it is (re)initialized.
+ *
+ * @param cause Flags from @ref reset_cause.
+ * @return true if @ref Retained::shown holds a valid status to resume.
+ */
+static bool retained_restore(uint8_t cause) {
+  if (!(cause & RSTCTRL_PORF_bm) &&
+      (retained.magic == RETAINED_MAGIC) &&
+      (retained.crc == retained_crc()) &&
+      (retained.shown != (uint8_t)UNKNOWN)) {
+    STAT_INC(warmRestarts);
+    return true;
+  }
+
+  retained.magic = RETAINED_MAGIC;
+  retained.shown = (uint8_t)UNKNOWN;
+  retained.crc   = retained_crc();
+  return false;
+}
+
+/**
+ * @brief Remember @p st as the state to resume after a warm reset.
+ * @param st Shown status, or @ref UNKNOWN to resume nothing.
+ */
+static void retained_store(Status st) {
+  retained.shown = (uint8_t)st;
+  retained.crc   = retained_crc();
+}
+#endif
+
+// ================== Stats block ==================
+#if STATS_BLOCK
+/**
+ * @brief Clear @ref Stats after power-on or if its layout changed.
+ *
+ * Same policy as @ref retained_restore: a brown-out reset trips above the
+ * SRAM retention voltage, so it keeps SRAM like any other warm reset.
+ * @param cause Flags from @ref reset_cause.
+ */
+static void stats_init(uint8_t cause) {
+  if ((cause & RSTCTRL_PORF_bm) ||
+      (stats.version != STATS_VERSION) || (stats.size != sizeof(Stats))) {
+    memset(&stats, 0, sizeof(Stats));
+    stats.version = STATS_VERSION;
+    stats.size    = sizeof(Stats);
+  }
+
+  // Export the block address to the linker, see STATS_ADDR
+  __asm__ volatile(".global __stats_start\n\t.set __stats_start, %0" ::"i"(0x800000UL + STATS_ADDR));
+}
+
+#if STATS_LOOP_TIME
+/**
+ * @brief Track the longest time between two consecutive loop() entries.
+ */
+static void stats_loop_tick(void) {
+  static uint16_t prevUs  = 0;
+  static bool     started = false;
+  const uint16_t us = (uint16_t)micros();
+
+  if (started && ((uint16_t)(us - prevUs) > stats.maxLoopUs)) {
+    stats.maxLoopUs = us - prevUs;
+  }
+  prevUs  = us;
+  started = true;
+}
+#endif
+#endif
+
 // ================== State ==================
 static bool     seenBooted           = false;
 static Status   lastShown            = UNKNOWN;
@@ -268,6 +1072,26 @@ static uint32_t lastBlinkToggleMs    = 0;
 static bool     blinkPhase           = false;  // false: red, true: purple
 static uint32_t lastKnownStatusMs    = 0;
 static uint32_t lastRequestMs        = 0;
+#if WARM_RESTART
+static bool     revalidating         = false;  // resumed after warm reset, waiting for a report
+#endif
+#if SET_REPORT_MASK
+static bool     reportMaskSent       = false;
+#endif
+
+/**
+ * @brief Show @p st on the LED if it differs from the currently shown status.
+ * @param st Parsed status value (not @ref UNKNOWN).
+ */
+static void updateShown(Status st) {
+  if (st != lastShown) {
+    showStatus(st);
+    lastShown = st;
+#if WARM_RESTART
+    retained_store(st);
+#endif
+  }
+}
 
 // ================== Arduino lifecycle ==================
 
@@ -275,18 +1099,53 @@ static uint32_t lastRequestMs        = 0;
  * @brief Arduino setup: init UART, LED, and start blinking until booted message arrives.
  */
 void setup(void) {
+#if WARM_RESTART || STATS_BLOCK || SET_REPORT_MASK
+  // What survived the reset depends on its cause
+  const uint8_t resetCause = reset_cause();
+#endif
+#if SET_REPORT_MASK
+  reportMaskSent = !(resetCause & RSTCTRL_PORF_bm);  // the controller setting is still there
+#endif
+#if STATS_BLOCK
+  stats_init(resetCause);
+#endif
+
   uart_init();
 
   // LED pin as output
   PORTA.DIR |= PIN3_bm;
 
   // NeoPixel init
-  leds.begin();
-  leds.setBrightness(BRIGHTNESS);
+  leds.begin();  // brightness is baked into PALETTE, no setBrightness()
+
+#if RENDER_SLAVE
+  leds.show();  // all off until the first frame arrives
+  return;
+#endif
 
-  // Startup: blink red/purple until BOOTED appears
-  setColor(COL_RED);
   lastBlinkToggleMs = millis();
+  bool pollNow = ATTACH_ON_REPORT;
+
+#if WARM_RESTART
+  if (retained_restore(resetCause)) {
+    // Warm reset: controller is most likely still running, resume its last state
+    seenBooted = true;
+    updateShown((Status)retained.shown);
+    lastKnownStatusMs = lastBlinkToggleMs;
+    revalidating = true;
+    pollNow = true;  // revalidate with one request, see WARM_REVALIDATE_MS
+  } else
+#endif
+  {
+    // Startup: blink red/purple until BOOTED appears
+    setColor(PAL_RED);
+  }
+
+  if (pollNow) {
+    // Controller may already be running: ask right away instead of after REQUEST_TIMEOUT_MS
+    request_status();
+    lastRequestMs = lastBlinkToggleMs;
+  }
 }
 
 /**
@@ -295,32 +1154,85 @@ void setup(void) {
 void loop(void) {
   const uint32_t now = millis();
 
+#if STATS_BLOCK && STATS_LOOP_TIME
+  stats_loop_tick();
+#endif
+
+#if RENDER_SLAVE
+  static bool     framePending = false;
+  static uint32_t lastShowMs   = 0;
+
+  if (slave_receive()) {
+    framePending = true;  // a newer frame simply replaces a pending one
+  }
+  if (framePending && ((now - lastShowMs) >= SLAVE_FRAME_INTERVAL_MS)) {
+    leds.show();
+    uart_write(SLAVE_ACK);
+    STAT_INC(shows);
+    lastShowMs   = now;
+    framePending = false;
+  }
+  return;
+#endif
+
   // Parse any incoming line
   const Status st = parse_status();
 
   if (st != UNKNOWN) {
+    STAT_INC(perState[st]);
+
     if (st == BOOTED) {
       seenBooted        = true;    // connected and ready
       lastKnownStatusMs = now;
       lastRequestMs     = now;     // first "?\n" after REQUEST_TIMEOUT_MS
-      if (st != lastShown) {
-        showStatus(st);
-        lastShown = st;
-      }
-    } else if (seenBooted) {
+      updateShown(st);
+    } else if (seenBooted || ATTACH_ON_REPORT) {
+      seenBooted        = true;    // a well-formed report proves a live link
       lastKnownStatusMs = now;
-      if (st != lastShown) {
-        showStatus(st);
-        lastShown = st;
-      }
+      updateShown(st);
     }
-    // else: not yet booted; keep blinking logic below
+    // else: not yet booted and attach disabled; keep blinking logic below
+
+#if WARM_RESTART
+    revalidating = false;  // controller answered, retained state confirmed or replaced
+#endif
+
+#if FEED_METER
+    if (seenBooted && feed_update(st, now) && (lastShown == RUN)) {
+      showStatus(RUN);  // tint changed while running
+    }
+#endif
+
+#if SET_REPORT_MASK
+    // Settings are only accepted while the controller is not in a motion state
+    if (seenBooted && !reportMaskSent && (st == BOOTED || st == IDLE || st == ALARM)) {
+      uart_write_str(REPORT_MASK_CMD);
+      reportMaskSent = true;
+    }
+#endif
+  }
+
+#if WARM_RESTART
+  if (revalidating && ((now - lastRequestMs) >= WARM_REVALIDATE_MS)) {
+    // No answer after the warm reset: don't trust the retained color, wait for boot
+    revalidating = false;
+    seenBooted   = false;
+    lastShown    = UNKNOWN;
+    retained_store(UNKNOWN);
+    setColor(PAL_RED);
+    blinkPhase        = false;
+    lastBlinkToggleMs = now;
   }
+#endif
+
+#ifdef DEBUG
+  trace_drain();  // one character per loop, see trace_drain()
+#endif
 
   // If no new status for REQUEST_TIMEOUT_MS, ask GRBL for status with "?\n"
   if (((now - lastKnownStatusMs) >= REQUEST_TIMEOUT_MS) &&
       ((now - lastRequestMs)    >= REQUEST_TIMEOUT_MS)) {
-    uart_write_str("?\n");
+    request_status();
     lastRequestMs = now;
   }
 
@@ -328,7 +1240,7 @@ void loop(void) {
   if (!seenBooted) {
     if ((now - lastBlinkToggleMs) >= BLINK_INTERVAL) {
       blinkPhase = !blinkPhase;
-      setColor(blinkPhase ? COL_PUR : COL_RED);
+      setColor(blinkPhase ? PAL_PUR : PAL_RED);
       lastBlinkToggleMs = now;
     }
     return;  // wait for BOOTED
@@ -0,0 +1,44 @@
+"""PlatformIO post-link check: static RAM must end below the Stats block.
+
+Fails the build if _end (end of .noinit, the last static RAM section) lies
+above __stats_start (see STATS_ADDR in src/main.cpp).
+
+Images built without STATS_BLOCK have no __stats_start and are skipped.
+Used from platformio.ini: extra_scripts = post:tools/check_ram_layout.py
+"""
+
+import subprocess
+
+Import("env")  # noqa: F821 (provided by PlatformIO/SCons)
+
+
+def read_symbols(elf):
+    nm = env.subst("$NM")  # noqa: F821
+    if not nm:
+        cc = env.subst("$CC")  # noqa: F821 (e.g. ".../avr-gcc")
+        nm = cc[:-3] + "nm" if cc.endswith("gcc") else "avr-nm"
+    out = subprocess.run([nm, elf], capture_output=True, text=True, check=True).stdout
+    symbols = {}
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 3:
+            symbols[parts[2]] = int(parts[0], 16)
+    return symbols
+
+
+def check_ram_layout(target, source, env):
+    symbols = read_symbols(str(target[0]))
+    if "__stats_start" not in symbols:
+        return 0
+    stats = symbols["__stats_start"] & 0xFFFF  # data space: drop the 0x800000 offset
+    end = symbols["_end"] & 0xFFFF
+    if end > stats:
+        print(f"Error: static RAM ends at 0x{end:04X}, overlapping the Stats block at "
+              f"0x{stats:04X}. Reduce NUM_LEDS or disable features.")
+        return 1
+    print(f"RAM layout: static RAM ends at 0x{end:04X}, {stats - end} bytes "
+          f"below Stats at 0x{stats:04X} left for the stack.")
+    return 0
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", check_ram_layout)  # noqa: F821
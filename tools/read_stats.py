@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Read and decode the Stats block of a running indicator over UPDI.
+
+Uses the same pymcuprog serial-UPDI setup as the upload in platformio.ini.
+The layout must match struct Stats in src/main.cpp (STATS_VERSION).
+Entering a UPDI session may reset the MCU; the counters survive that
+(they are only cleared on power-on reset).
+
+Usage: read_stats.py [--port COM8] [--baud 115200]
+"""
+
+import argparse
+import struct
+
+from pymcuprog.backend import Backend, SessionConfig
+from pymcuprog.toolconnection import ToolSerialConnection
+
+STATS_VERSION = 3
+STATS_SIZE = 34
+SRAM_SIZE = 256  # ATtiny412
+F_CPU = 20000000
+
+STATES = ["BOOTED", "IDLE", "RUN", "HOLD", "JOG", "DOOR", "HOME", "ALARM"]
+FIELDS = ["lines", "rxErrors", "rxOverruns", "polls", "shows", "maxLoopUs", "feedEff",
+          "warmRestarts"]
+LAYOUT = "<BBH8H7H"  # version, size, lines, perState[8], then FIELDS[1:]
+
+
+def read_block(port, baud, device):
+    backend = Backend()
+    backend.connect_to_tool(ToolSerialConnection(serialport=port, baudrate=baud))
+    try:
+        backend.start_session(SessionConfig(device))
+        offset = SRAM_SIZE - STATS_SIZE  # Stats sits at the top of SRAM
+        return bytes(backend.read_memory("internal_sram", offset, STATS_SIZE)[0].data)
+    finally:
+        backend.end_session()
+        backend.disconnect_from_tool()
+
+
+def decode(raw):
+    values = struct.unpack_from(LAYOUT, raw)
+    version, size, lines = values[0:3]
+    if version != STATS_VERSION or size != struct.calcsize(LAYOUT):
+        raise SystemExit(f"unexpected Stats block (version {version}, size {size}); "
+                         "firmware built without STATS_BLOCK or layout changed?")
+    stats = {"lines": lines}
+    stats.update(zip(STATES, values[3:11]))
+    stats.update(zip(FIELDS[1:], values[11:]))
+    return stats
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--port", default="COM8")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--device", default="attiny412")
+    args = ap.parse_args()
+
+    stats = decode(read_block(args.port, args.baud, args.device))
+    for name, value in stats.items():
+        print(f"{name:>12}: {value}")
+    if stats["maxLoopUs"]:
+        cycles = stats["maxLoopUs"] * (F_CPU // 1000000)
+        print(f"{'':>12}  (max loop ~{cycles} cycles at {F_CPU // 1000000} MHz)")
+    if stats["feedEff"]:
+        print(f"{'':>12}  (feed efficiency {100.0 * stats['feedEff'] / 256:.0f} % in Run)")
+
+
+if __name__ == "__main__":
+    main()
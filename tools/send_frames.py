@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Send pixel frames to an indicator built with RENDER_SLAVE and report frames/s.
+
+Frames are encoded as the firmware expects (see "Render-slave frames" in
+src/main.cpp): [type][payload][CRC-8 CCITT], COBS-encoded, 0x00-terminated.
+The device answers every LED update with one ACK byte (0x06), and the
+benchmark streams a moving rainbow stop-and-wait on it (see SLAVE_ACK in
+src/main.cpp). Only acknowledged frames count, so the printed rate is the
+rate of frames actually shown, next to the theoretical link limit.
+
+Usage: send_frames.py PORT [--baud 115200] [--leds 2] [--seconds 5] [--delta]
+Requires pyserial.
+"""
+
+import argparse
+import time
+
+import serial
+
+FRAME_FULL = 0x01
+FRAME_DELTA = 0x02
+ACK = 0x06
+
+
+def crc8_ccitt(data):
+    """Same as avr-libc _crc8_ccitt_update() starting from 0."""
+    crc = 0
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for b in data:
+        if b == 0:
+            out.append(len(block) + 1)
+            out += block
+            block.clear()
+        else:
+            block.append(b)
+            if len(block) == 254:
+                out.append(0xFF)
+                out += block
+                block.clear()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def encode_frame(ftype, payload):
+    body = bytes([ftype]) + payload
+    return cobs_encode(body + bytes([crc8_ccitt(body)])) + b"\0"
+
+
+def full_frame(grb):
+    return encode_frame(FRAME_FULL, bytes(grb))
+
+
+def delta_frame(offset, grb):
+    return encode_frame(FRAME_DELTA, offset.to_bytes(2, "little") + bytes(grb))
+
+
+def wheel(pos, level=31):
+    """GRB bytes of a rainbow color at pos (0..255), scaled to level."""
+    pos &= 0xFF
+    if pos < 85:
+        r, g, b = 255 - pos * 3, pos * 3, 0
+    elif pos < 170:
+        pos -= 85
+        r, g, b = 0, 255 - pos * 3, pos * 3
+    else:
+        pos -= 170
+        r, g, b = pos * 3, 0, 255 - pos * 3
+    return [g * level // 255, r * level // 255, b * level // 255]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("port")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--leds", type=int, default=2, help="NUM_LEDS of the firmware")
+    ap.add_argument("--seconds", type=float, default=5.0)
+    ap.add_argument("--delta", action="store_true", help="update one LED per frame")
+    ap.add_argument("--timeout", type=float, default=0.1,
+                    help="seconds to wait for the ACK of a frame")
+    args = ap.parse_args()
+
+    with serial.Serial(args.port, args.baud, timeout=args.timeout) as port:
+        port.reset_input_buffer()
+        frames = 0
+        shown = 0
+        sent = 0
+        start = time.perf_counter()
+        while time.perf_counter() - start < args.seconds:
+            step = frames & 0xFF
+            if args.delta:
+                led = frames % args.leds
+                data = delta_frame(led * 3, wheel(step + led * 16))
+            else:
+                grb = []
+                for led in range(args.leds):
+                    grb += wheel(step + led * 16)
+                data = full_frame(grb)
+            port.write(data)
+            frames += 1
+            sent += len(data)
+            if port.read(1) == bytes([ACK]):
+                shown += 1
+            # else: frame lost or rejected (CRC), the timeout resynchronizes
+        elapsed = time.perf_counter() - start
+
+    bits_per_byte = 10  # 8N1
+    print(f"{frames} frames sent, {shown} shown, {sent} bytes in {elapsed:.2f} s")
+    print(f"achieved:   {shown / elapsed:8.1f} frames/s")
+    print(f"link limit: {args.baud / bits_per_byte / (sent / frames):8.1f} frames/s "
+          f"({sent / frames:.1f} bytes/frame at {args.baud} baud)")
+    print(f"show limit: {1 / (30e-6 * args.leds):8.1f} frames/s "
+          f"(~30 us per LED with interrupts off)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Decode the debug trace of a DEBUG build into a readable timeline.
+
+Records are GRBL comments of hex digits (see "Debug event trace" in
+src/main.cpp): "(EttttDD)" is event E at millis() & 0xFFFF with data DD,
+"(Stttttttt)" is a time-sync record carrying the full millis(). Other bytes
+on TX (status requests "?\\n", settings, line ends) are skipped. 16-bit
+stamps are unwrapped to the nearest value after the previous record; sync
+records re-anchor the timeline and come at least every 10 s.
+
+Usage: trace_decode.py FILE           (capture of the indicator's TX)
+       trace_decode.py --port COM9 [--baud 115200]
+Reading from a port requires pyserial.
+"""
+
+import argparse
+import re
+import sys
+
+EVENTS = ["LINE", "STATUS", "POLL", "SHOW", "RXERR", "LOST"]
+STATUS = {0: "BOOTED", 1: "IDLE", 2: "RUN", 3: "HOLD", 4: "JOG", 5: "DOOR",
+          6: "HOME", 7: "ALARM", 255: "UNKNOWN"}
+COLORS = ["red", "orange", "yellow", "green", "cyan", "purple", "blue"]
+
+TOKEN = re.compile(rb"\((S[0-9A-F]{8}|[0-9A-F]{7})\)")
+
+
+def describe(event, data):
+    name = EVENTS[event]
+    if name == "LINE":
+        return f"len={data}"
+    if name == "STATUS":
+        return STATUS.get(data, str(data))
+    if name == "POLL":
+        return "$G" if data == 1 else "?"
+    if name == "SHOW":
+        return COLORS[data] if data < len(COLORS) else str(data)
+    if name == "RXERR":
+        flags = [f for bit, f in ((0x40, "BUFOVF"), (0x04, "FERR"), (0x02, "PERR")) if data & bit]
+        return "|".join(flags)
+    if name == "LOST":
+        return f"{data} records"
+    return ""
+
+
+def records(chunks):
+    """Yield ("S", ms32, None) or (event, ms16, data) from an iterable of byte chunks."""
+    pending = b""
+    for chunk in chunks:
+        pending += chunk
+        end = 0
+        for m in TOKEN.finditer(pending):
+            text = m.group(1).decode()
+            if text[0] == "S":
+                yield "S", int(text[1:], 16), None
+            elif int(text[0], 16) < len(EVENTS):
+                yield int(text[0], 16), int(text[1:5], 16), int(text[5:7], 16)
+            end = m.end()
+        # keep a possibly incomplete record for the next chunk
+        start = pending.rfind(b"(", end)
+        pending = pending[start:] if start >= 0 else b""
+
+
+def read_file(path):
+    with open(path, "rb") as f:
+        while True:
+            chunk = f.read(4096)
+            if not chunk:
+                return
+            yield chunk
+
+
+def read_port(port, baud):
+    import serial
+    with serial.Serial(port, baud, timeout=0.1) as ser:
+        while True:
+            yield ser.read(256)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("file", nargs="?")
+    ap.add_argument("--port")
+    ap.add_argument("--baud", type=int, default=115200)
+    args = ap.parse_args()
+    if not args.file and not args.port:
+        ap.error("give a capture FILE or --port")
+
+    source = read_port(args.port, args.baud) if args.port else read_file(args.file)
+    t = None
+    try:
+        for event, ms, data in records(source):
+            if event == "S":
+                t = ms
+                continue
+            if t is None:
+                t = ms  # no sync seen yet: time relative to a 16-bit epoch
+            t += ((ms - t + 0x8000) & 0xFFFF) - 0x8000  # nearest 16-bit match
+            print(f"{t:10d} ms  {EVENTS[event]:<6} {describe(event, data)}")
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())